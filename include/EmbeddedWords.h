@@ -0,0 +1,26 @@
+#pragma once
+#include <stdint.h>
+#include "WordsData.h" // generated by scripts/embed_words.py
+
+// Built-in word list from SD/words.txt, embedded in flash at build time.
+// Words are packed by packWord() and looked up by minimal perfect hash.
+
+// Hash of packed word with seed. Must match word_hash() in scripts/embed_words.py
+inline uint32_t wordHash(uint32_t packed, uint32_t seed)
+{
+  uint32_t h = packed ^ (seed * 0x9E3779B9u);
+  h ^= h >> 16;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+  return h;
+}
+
+// Return true if packed word is in built-in word list. Single probe, no RAM copy
+inline bool embeddedWordExists(uint32_t packed)
+{
+  int16_t seed = embeddedWordSeeds[wordHash(packed, 0) % embeddedWordCount];
+  uint32_t slot = seed < 0 ? -seed - 1 : wordHash(packed, seed) % embeddedWordCount;
+  return embeddedWords[slot] == packed;
+}
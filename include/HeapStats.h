@@ -0,0 +1,13 @@
+#pragma once
+#include <Arduino.h>
+
+// Heap allocation counter and low-watermark report.
+// Enabled with HEAP_STATS build flag (env:m5stack-fire-heapstats), which also
+// wraps malloc/calloc/realloc at link time. Otherwise these compile to nothing.
+#ifdef HEAP_STATS
+uint32_t heapAllocCount();
+void reportHeap(const char *label, uint32_t allocCountBefore);
+#else
+inline uint32_t heapAllocCount() { return 0; }
+inline void reportHeap(const char *label, uint32_t allocCountBefore) {}
+#endif
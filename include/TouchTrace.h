@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+#include <M5EPD.h>
+
+// Touch event trace recorder.
+// Enabled with TOUCH_TRACE build flag (env:m5stack-fire-trace). Every raw touch
+// sample, finger release, key event and EPD push is recorded with micros() into
+// /traceN.bin in SD card. env:native replays the trace through loop().
+// Otherwise these compile to nothing.
+
+#define traceMagic "PTRC"
+#define traceVersion 2
+
+// Record types
+#define traceTypeTouch 1   // raw sample of M5.TP.readFinger(0). x, y, width = size, value = id
+#define traceTypeRelease 2 // M5.TP reported finger up
+#define traceTypeKey 3     // keyPushed(). value = key
+#define traceTypePush 4    // pushView(). x, y, width, height, value = update mode
+#define traceTypeAnswer 5  // startNewGame() chose answer. x = low 16 bits, y = high bits of packWord(answer)
+
+// File starts with header, followed by records. Little endian, no padding
+struct __attribute__((packed)) TraceHeader
+{
+  char magic[4];       // traceMagic
+  uint16_t version;    // traceVersion
+  uint16_t recordSize; // sizeof(TraceRecord)
+  char answer[5];      // game state when recording started
+  char table[6][5];
+};
+
+struct __attribute__((packed)) TraceRecord
+{
+  uint32_t time; // micros()
+  uint8_t type;
+  uint8_t value;
+  uint16_t x;
+  uint16_t y;
+  uint16_t width;
+  uint16_t height;
+};
+
+#ifdef TOUCH_TRACE
+void traceBegin(const char *answer, const char table[6][5]);
+void traceTouch(const tp_finger_t &finger);
+void traceRelease();
+void traceKey(char key);
+void tracePush(int x, int y, int width, int height, m5epd_update_mode_t mode);
+void traceAnswer(uint32_t packedAnswer);
+void traceFlush();
+#else
+inline void traceBegin(const char *answer, const char table[6][5]) {}
+inline void traceTouch(const tp_finger_t &finger) {}
+inline void traceRelease() {}
+inline void traceKey(char key) {}
+inline void tracePush(int x, int y, int width, int height, m5epd_update_mode_t mode) {}
+inline void traceAnswer(uint32_t packedAnswer) {}
+inline void traceFlush() {}
+#endif
@@ -0,0 +1,135 @@
+# Generate include/WordsData.h from SD/words.txt
+#
+# The words are packed into 25 bits (same as packWord() in src/main.cpp) and
+# placed by a minimal perfect hash (hash and displace), so the sketch can
+# validate a word with a single probe into flash without loading anything.
+#
+# Runs as PlatformIO pre-script (extra_scripts) or standalone:
+#   python scripts/embed_words.py
+
+import os
+import sys
+
+WORDS_FILE = os.path.join("SD", "words.txt")
+HEADER_FILE = os.path.join("include", "WordsData.h")
+MASK = 0xFFFFFFFF
+
+
+def pack_word(word):
+    """Pack 5-letter uppercase word into 25 bits, 5 bits per letter"""
+    packed = 0
+    for c in word:
+        packed = (packed << 5) | (ord(c) - ord("A") + 1)
+    return packed
+
+
+def word_hash(packed, seed):
+    """Must match wordHash() in include/EmbeddedWords.h"""
+    h = (packed ^ (seed * 0x9E3779B9)) & MASK
+    h ^= h >> 16
+    h = (h * 0x85EBCA6B) & MASK
+    h ^= h >> 13
+    h = (h * 0xC2B2AE35) & MASK
+    h ^= h >> 16
+    return h
+
+
+def load_words(path):
+    """Same rule as loadWordList(): lines of 5 letters, case insensitive"""
+    words = set()
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if len(line) == 5 and line.isascii() and line.isalpha():
+                words.add(pack_word(line.upper()))
+    return sorted(words)
+
+
+def build_perfect_hash(keys):
+    """Return (slots, seeds). Lookup: seed = seeds[hash(key, 0) % n],
+    slot = -seed - 1 if seed < 0 else hash(key, seed) % n"""
+    n = len(keys)
+    buckets = [[] for _ in range(n)]
+    for key in keys:
+        buckets[word_hash(key, 0) % n].append(key)
+
+    seeds = [0] * n
+    slots = [None] * n
+    order = sorted(range(n), key=lambda b: len(buckets[b]), reverse=True)
+
+    # Buckets with collisions: search seed which puts all keys in free slots
+    index = 0
+    while index < n and len(buckets[order[index]]) > 1:
+        bucket = buckets[order[index]]
+        seed = 1
+        while True:
+            placed = set(word_hash(key, seed) % n for key in bucket)
+            if len(placed) == len(bucket) and all(slots[s] is None for s in placed):
+                break
+            seed += 1
+            if seed > 0x7FFF:
+                sys.exit("embed_words.py: no seed found for bucket")
+        for key in bucket:
+            slots[word_hash(key, seed) % n] = key
+        seeds[order[index]] = seed
+        index += 1
+
+    # Single key buckets: put directly into remaining free slots
+    free = [s for s in range(n) if slots[s] is None]
+    while index < n and len(buckets[order[index]]) == 1:
+        slot = free.pop()
+        slots[slot] = buckets[order[index]][0]
+        seeds[order[index]] = -slot - 1
+        index += 1
+
+    return slots, seeds
+
+
+def format_array(values, per_line=10):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def generate(project_dir):
+    words_path = os.path.join(project_dir, WORDS_FILE)
+    header_path = os.path.join(project_dir, HEADER_FILE)
+
+    keys = load_words(words_path)
+    if len(keys) == 0 or len(keys) > 0x7FFF:
+        sys.exit("embed_words.py: %s must contain 1 - 32767 words" % WORDS_FILE)
+    slots, seeds = build_perfect_hash(keys)
+
+    header = """// Generated by scripts/embed_words.py from %s. Do not edit
+#pragma once
+#include <stdint.h>
+
+constexpr uint16_t embeddedWordCount = %d;
+
+// Words packed by packWord(), placed in slots by minimal perfect hash
+constexpr uint32_t embeddedWords[embeddedWordCount] = {
+%s
+};
+
+// Seed for each hash bucket. Negative value -s-1 points slot s directly
+constexpr int16_t embeddedWordSeeds[embeddedWordCount] = {
+%s
+};
+""" % (WORDS_FILE.replace(os.sep, "/"), len(keys), format_array(slots), format_array(seeds, 16))
+
+    # Rewrite only when changed to avoid rebuilding every time
+    if os.path.exists(header_path):
+        with open(header_path) as f:
+            if f.read() == header:
+                return
+    with open(header_path, "w") as f:
+        f.write(header)
+    print("embed_words.py: %d words written to %s" % (len(keys), HEADER_FILE))
+
+
+if __name__ == "__main__":
+    generate(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+else:
+    Import("env")  # noqa: F821 (defined by PlatformIO)
+    generate(env.subst("$PROJECT_DIR"))  # noqa: F821
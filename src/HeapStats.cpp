@@ -0,0 +1,45 @@
+#ifdef HEAP_STATS
+#include "HeapStats.h"
+
+// Count of heap allocations since boot, incremented by the wrappers below
+static volatile uint32_t allocCount = 0;
+
+// Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+extern "C"
+{
+  void *__real_malloc(size_t size);
+  void *__real_calloc(size_t count, size_t size);
+  void *__real_realloc(void *ptr, size_t size);
+
+  void *__wrap_malloc(size_t size)
+  {
+    allocCount++;
+    return __real_malloc(size);
+  }
+
+  void *__wrap_calloc(size_t count, size_t size)
+  {
+    allocCount++;
+    return __real_calloc(count, size);
+  }
+
+  void *__wrap_realloc(void *ptr, size_t size)
+  {
+    allocCount++;
+    return __real_realloc(ptr, size);
+  }
+}
+
+// Return number of heap allocations since boot
+uint32_t heapAllocCount()
+{
+  return allocCount;
+}
+
+// Print allocations since allocCountBefore, free heap and lowest free heap since boot
+void reportHeap(const char *label, uint32_t allocCountBefore)
+{
+  uint32_t allocations = allocCount - allocCountBefore; // take before printing
+  Serial.printf("[heap] %s: %u allocs, free %u, low %u\n", label, allocations, ESP.getFreeHeap(), ESP.getMinFreeHeap());
+}
+#endif
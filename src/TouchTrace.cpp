@@ -0,0 +1,87 @@
+#if defined(TOUCH_TRACE) && !defined(NATIVE_REPLAY)
+#include "TouchTrace.h"
+
+// Records are buffered and written to SD in blocks, so SD latency is not added to every touch
+#define traceBufferCount 256
+static TraceRecord traceBuffer[traceBufferCount];
+static int traceBufferUsed = 0;
+static File traceFile;
+
+// Append record to buffer, and write buffer when it is full
+static void traceRecord(uint8_t type, uint8_t value, uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+  if (!traceFile)
+    return;
+  TraceRecord &record = traceBuffer[traceBufferUsed];
+  record.time = micros();
+  record.type = type;
+  record.value = value;
+  record.x = x;
+  record.y = y;
+  record.width = width;
+  record.height = height;
+  traceBufferUsed++;
+  if (traceBufferUsed == traceBufferCount)
+    traceFlush();
+}
+
+// Open new /traceN.bin in SD card and write header with current game state
+void traceBegin(const char *answer, const char table[6][5])
+{
+  char fileName[24];
+  int fileIndex = 1;
+  do
+  {
+    snprintf(fileName, sizeof(fileName), "/trace%d.bin", fileIndex);
+    fileIndex++;
+  } while (SD.exists(fileName));
+  traceFile = SD.open(fileName, FILE_WRITE);
+  if (!traceFile)
+    return;
+
+  TraceHeader header;
+  memcpy(header.magic, traceMagic, sizeof(header.magic));
+  header.version = traceVersion;
+  header.recordSize = sizeof(TraceRecord);
+  memcpy(header.answer, answer, sizeof(header.answer));
+  memcpy(header.table, table, sizeof(header.table));
+  traceFile.write((const uint8_t *)&header, sizeof(header));
+  traceFile.flush();
+  Serial.printf("Touch trace: %s\n", fileName);
+}
+
+void traceTouch(const tp_finger_t &finger)
+{
+  traceRecord(traceTypeTouch, finger.id, finger.x, finger.y, finger.size, 0);
+}
+
+void traceRelease()
+{
+  traceRecord(traceTypeRelease, 0, 0, 0, 0, 0);
+}
+
+void traceKey(char key)
+{
+  traceRecord(traceTypeKey, key, 0, 0, 0, 0);
+}
+
+void tracePush(int x, int y, int width, int height, m5epd_update_mode_t mode)
+{
+  traceRecord(traceTypePush, mode, x, y, width, height);
+}
+
+void traceAnswer(uint32_t packedAnswer)
+{
+  traceRecord(traceTypeAnswer, 0, packedAnswer & 0xFFFF, packedAnswer >> 16, 0, 0);
+}
+
+// Write buffered records to SD card
+void traceFlush()
+{
+  if (!traceFile || traceBufferUsed == 0)
+    return;
+  traceFile.write((const uint8_t *)traceBuffer, traceBufferUsed * sizeof(TraceRecord));
+  traceFile.flush();
+  traceBufferUsed = 0;
+}
+#endif
@@ -1,7 +1,11 @@
 #include <Arduino.h>
 #include <M5EPD.h>
-#include <set>
+#include <algorithm>
 #include <vector>
+#include <soc/soc_memory_layout.h>
+#include "EmbeddedWords.h"
+#include "HeapStats.h"
+#include "TouchTrace.h"
 
 // Geometry constants
 #define screenWidth 540
@@ -28,22 +32,35 @@ int cellFontSize = 5;
 int keyFontSize = 3;
 
 // Canvas
+// Single 4bpp framebuffer for whole screen. Buttons, input line and keyboard are views on it
 M5EPD_Canvas screenCanvas(&M5.EPD);
-M5EPD_Canvas buttonCanvas(&M5.EPD);
-M5EPD_Canvas lineCanvas(&M5.EPD);
-// M5EPD_Canvas keyCanvas(&M5.EPD);
-M5EPD_Canvas keyboardCanvas(&M5.EPD);
 tp_finger_t lastFingerItem;
 
-// Valid word set will be loaded from SD card
-std::set<String> wordSet;
+// Rectangle on screenCanvas which is drawn in place and pushed alone by pushView()
+struct CanvasView
+{
+  int x;
+  int y;
+  int width;
+  int height;
+};
+const CanvasView fullScreenView = {0, 0, screenWidth, screenHeight};
+const CanvasView newButtonView = {margin, margin, cellWidth, buttonHeight};
+const CanvasView offButtonView = {margin + cellWidth * 4, margin, cellWidth, buttonHeight};
+const CanvasView keyboardView = {margin, margin + buttonHeight + margin + cellHeight * 6, keyWidth * 10 + 1, keyHeight * 3 + 1};
+
+// Valid word list will be loaded from SD card. Sorted words packed by packWord()
+// If empty, built-in word list in EmbeddedWords.h is used instead
+std::vector<uint32_t> wordList;
 
 // Valiables for game state
-String answer = "PAPER";
-String inputLine = "";
-String hit = "";
-String contained = "";
-String notContained = "";
+// Fixed-capacity buffers so that typing and redrawing never touch the heap
+char answer[6] = "PAPER";
+char inputLine[6] = "";
+int inputLength = 0;
+char hit[27] = "";          // letters used on correct position
+char contained[27] = "";    // letters contained in answer on other position
+char notContained[27] = ""; // letters not contained in answer
 
 int lineIndex = -1;
 char table[6][5];
@@ -56,29 +73,38 @@ char keyLine2[] = "ASDFGHJKL";
 char keyLine3[] = "=ZXCVBNM <";
 
 // Font geometry caches
-std::map<String, int> widthForStringMap;
-M5EPD_Canvas widthCanvas(&M5.EPD);
+int16_t charWidthCache[2][128]; // [0]: cellFontSize, [1]: keyFontSize
 int _cellFontHeight;
 int _keyFontHeight;
 
 // Functions
 // Key and Input
 void keyPushed(int keyboardX, int keyboardY, char key);
-void checkWordOnInputLine();
-void addWordToTable(String line);
+bool checkWordOnInputLine();
+void addWordToTable(const char *line);
+void addLetter(char *letters, char letter);
+bool isValidWord(const char *word);
 void updateInputLineArea();
+CanvasView inputLineView();
 
 // Drawing
 void updateAllScreen();
 void drawKeyboard();
 void drawKey(char key, int x, int y);
+void pushView(const CanvasView &view, m5epd_update_mode_t mode);
 
 // Utilities
-int stringWidth(String string, int fontSize);
+int stringWidth(const char *string, int fontSize);
+int charWidth(char c, int fontSize);
+void measureFontGeometry();
 int cellFontHeight();
 int keyFontHeight();
 int batteryPercent();
 void savePGM(M5EPD_Canvas &canvas);
+void reportFramebuffer();
+uint32_t packWord(const char *word);
+void unpackWord(uint32_t packed, char *word);
+size_t readLine(File &file, char *buffer, size_t size);
 
 // Load and save state
 void loadState();
@@ -98,17 +124,9 @@ void setup()
   lastFingerItem.x = 0;
   lastFingerItem.y = 0;
 
-  // Create canvases
-  // canvas: main canvas for whole screen
-  // lineCanvas: display input line
-  // keyboardCanvas: display keyboard
+  // Create canvas for whole screen. It is the only framebuffer
   screenCanvas.createCanvas(screenWidth, screenHeight);
-  buttonCanvas.createCanvas(cellWidth, buttonHeight);
-  buttonCanvas.fillCanvas(blackColor);
-  lineCanvas.createCanvas(cellWidth * 5, cellHeight);
-  // keyCanvas.createCanvas(keyWidth, keyHeight);
-  // keyCanvas.fillCanvas(blackColor);
-  widthCanvas.createCanvas(cellWidth, cellHeight);
+  reportFramebuffer();
 
   // If font file exists in SD card, load the font
   if (SD.exists(fontName))
@@ -122,24 +140,19 @@ void setup()
   }
 
   screenCanvas.setTextColor(blackColor);
-  lineCanvas.setTextColor(blackColor);
-  lineCanvas.setTextSize(cellFontSize);
-
-  keyboardCanvas.createCanvas(keyWidth * 10 + 1, keyHeight * 3 + 1);
-  keyboardCanvas.setTextColor(blackColor);
-  keyboardCanvas.setTextSize(keyFontSize);
+  measureFontGeometry();
 
-  // Load valid words file fron words.txt in SD card
+  // Load valid words file fron words.txt in SD card, overriding built-in word list
   loadWordList();
 
   // Load current game state from state.txt in SD card
   loadState();
-
-  // Draw keyboard on keyboardCanvas
-  drawKeyboard();
+  traceBegin(answer, table);
 
   // Draw all screen and display it
   updateAllScreen();
+
+  reportHeap("setup", 0);
 }
 
 void loop()
@@ -161,6 +174,7 @@ void loop()
     {
       M5.TP.update();
       tp_finger_t fingerItem = M5.TP.readFinger(0);
+      traceTouch(fingerItem);
       if (lastFingerItem.x == fingerItem.x && lastFingerItem.y == fingerItem.y)
       { // if touched positiion is same with last position, discard
         return;
@@ -172,14 +186,18 @@ void loop()
       {
         if (fingerItem.x < margin + cellWidth)
         {
-          buttonCanvas.pushCanvas(margin, margin, UPDATE_MODE_DU);
+          uint32_t allocCount = heapAllocCount();
+          screenCanvas.fillRect(newButtonView.x, newButtonView.y, newButtonView.width, newButtonView.height, blackColor);
+          pushView(newButtonView, UPDATE_MODE_DU);
           startNewGame();
-          drawKeyboard();
           updateAllScreen();
+          reportHeap("new game", allocCount);
         }
         else if (fingerItem.x > margin + cellWidth * 4)
         {
-          buttonCanvas.pushCanvas(margin + cellWidth * 4, margin, UPDATE_MODE_DU);
+          screenCanvas.fillRect(offButtonView.x, offButtonView.y, offButtonView.width, offButtonView.height, blackColor);
+          pushView(offButtonView, UPDATE_MODE_DU);
+          traceFlush();
           delay(500);
           M5.shutdown();
         }
@@ -226,86 +244,109 @@ void loop()
         return;
       }
     }
+    else
+    {
+      traceRelease();
+    }
   }
 }
 
 // called when key-touch detected
 void keyPushed(int keyboardX, int keyboardY, char key)
 {
+  uint32_t allocCount = heapAllocCount();
   Serial.println(key);
-  //keyCanvas.pushCanvas(keyboardX, keyboardY, UPDATE_MODE_DU);
-  keyboardCanvas.ReversePartColor(keyboardX - margin + 1, keyboardY - (margin + buttonHeight + margin + cellHeight * 6) + 1, keyWidth - 2, keyHeight - 2);
-  keyboardCanvas.pushCanvas(margin, margin + buttonHeight + margin + cellHeight * 6, UPDATE_MODE_NONE);
-  M5.EPD.UpdateArea(keyboardX + 1, keyboardY + 1, keyWidth - 2, keyHeight - 2, UPDATE_MODE_DU);
-
+  traceKey(key);
+  CanvasView keyView = {keyboardX + 1, keyboardY + 1, keyWidth - 2, keyHeight - 2};
+  screenCanvas.ReversePartColor(keyView.x, keyView.y, keyView.width, keyView.height);
+  pushView(keyView, UPDATE_MODE_DU);
 
   delay(200);
-  keyboardCanvas.ReversePartColor(keyboardX - margin + 1, keyboardY - (margin + buttonHeight + margin + cellHeight * 6) + 1, keyWidth - 2, keyHeight - 2);
-  keyboardCanvas.pushCanvas(margin, margin + buttonHeight + margin + cellHeight * 6, UPDATE_MODE_NONE);
-  M5.EPD.UpdateArea(keyboardX + 1, keyboardY + 1, keyWidth - 2, keyHeight - 2, UPDATE_MODE_DU4);
+  screenCanvas.ReversePartColor(keyView.x, keyView.y, keyView.width, keyView.height);
+  pushView(keyView, UPDATE_MODE_DU4);
 
+  bool wordAdded = false;
   if (key == '=')
   { // if 5 letters in input line, check if the word exists
-    if (inputLine.length() >= 5)
+    if (inputLength >= 5)
     {
-      checkWordOnInputLine();
+      wordAdded = checkWordOnInputLine();
     }
   }
   else if (key == '<')
   { // Backspace
-    if (inputLine.length() >= 1)
+    if (inputLength >= 1)
     {
-      if (inputLine.length() == 1)
-      {
-        inputLine = "";
-      }
-      else if (inputLine.length() > 1)
-      {
-        inputLine = inputLine.substring(0, inputLine.length() - 1);
-      }
+      inputLength--;
+      inputLine[inputLength] = '\0';
       updateInputLineArea();
     }
   }
-  else if (key != ' ' && inputLine.length() < 5)
+  else if (key != ' ' && inputLength < 5)
   { // Other alphabet
-    inputLine += String(key);
+    inputLine[inputLength] = key;
+    inputLength++;
+    inputLine[inputLength] = '\0';
     updateInputLineArea();
   }
+
+  reportHeap("key", allocCount);
+
+  // Save state after key is handled. SD file access allocates, so it is reported separately
+  if (wordAdded)
+  {
+    allocCount = heapAllocCount();
+    saveState();
+    reportHeap("save state", allocCount);
+  }
 }
 
-// check if the word exists and put it into last line
-void checkWordOnInputLine()
+// check if the word exists and put it into last line. Returns true if the word was added
+bool checkWordOnInputLine()
 {
   if (lineIndex > 5)
-    return;
-  if (inputLine.length() == 5)
+    return false;
+  if (inputLength == 5)
   {
-    if (wordSet.count(inputLine) > 0)
+    if (isValidWord(inputLine))
     { // word exists in word list. valid input
       Serial.println("found in word list");
       addWordToTable(inputLine);
-      saveState();
-      drawKeyboard();
       updateAllScreen();
-      inputLine = "";
+      inputLine[0] = '\0';
+      inputLength = 0;
+      return true;
     }
     else
     { // word not found in word list. clear input
-      inputLine = "";
+      inputLine[0] = '\0';
+      inputLength = 0;
       updateInputLineArea();
     }
   }
+  return false;
+}
+
+// check if the word is in words.txt in SD card, or in built-in word list without it
+bool isValidWord(const char *word)
+{
+  uint32_t packed = packWord(word);
+  if (packed == 0)
+    return false;
+  if (!wordList.empty())
+    return std::binary_search(wordList.begin(), wordList.end(), packed);
+  return embeddedWordExists(packed);
 }
 
 // check if the word contains answer and update status
-void addWordToTable(String line)
+void addWordToTable(const char *line)
 {
   if (lineIndex > 5)
   {
     // Already last line. can't add word
     return;
   }
-  if (line.length() == 5)
+  if (strlen(line) == 5)
   {
     for (int i = 0; i < 5; i++)
     {
@@ -313,39 +354,58 @@ void addWordToTable(String line)
       if (line[i] == answer[i])
       { // Hit: correct char and correct position
         state[lineIndex][i] = 3;
-        hit += String(line[i]);
+        addLetter(hit, line[i]);
       }
-      else if (answer.indexOf(line[i]) > -1)
+      else if (strchr(answer, line[i]) != NULL)
       { // Contained: the answer contains char but not correct position
         state[lineIndex][i] = 2;
-        contained += String(line[i]);
+        addLetter(contained, line[i]);
       }
       else
       { // Not Contained: the answer doesn't contain char
         state[lineIndex][i] = 1;
-        notContained += String(line[i]);
+        addLetter(notContained, line[i]);
       }
     }
     lineIndex++;
   }
 }
 
+// Append letter to fixed-capacity letter set (27 bytes) unless it is already there
+void addLetter(char *letters, char letter)
+{
+  size_t length = strlen(letters);
+  if (letter == '\0' || length >= 26 || strchr(letters, letter) != NULL)
+    return;
+  letters[length] = letter;
+  letters[length + 1] = '\0';
+}
+
 // Update input line on screen when keys are typed
 void updateInputLineArea()
 {
-  lineCanvas.fillCanvas(0);
-  int y = 0;
+  CanvasView lineView = inputLineView();
+  screenCanvas.fillRect(lineView.x, lineView.y, lineView.width, lineView.height, whiteColor);
+  screenCanvas.setTextSize(cellFontSize);
+  int y = lineView.y;
   for (int i = 0; i < 5; i++)
   {
-    int x = i * cellWidth;
-    lineCanvas.drawRect(x, y, cellWidth + 1, cellHeight + 1, blackColor);
-    if (i < inputLine.length())
+    int x = lineView.x + i * cellWidth;
+    screenCanvas.drawRect(x, y, cellWidth + 1, cellHeight + 1, blackColor);
+    if (i < inputLength)
     {
-      String oneChar = inputLine.substring(i, i + 1);
-      lineCanvas.drawString(oneChar, x + (cellWidth - stringWidth(oneChar, cellFontSize)) / 2, y + (cellHeight - cellFontHeight()) / 2);
+      char oneChar[2] = {inputLine[i], '\0'};
+      screenCanvas.drawString(oneChar, x + (cellWidth - stringWidth(oneChar, cellFontSize)) / 2, y + (cellHeight - cellFontHeight()) / 2);
     }
   }
-  lineCanvas.pushCanvas(margin, margin + buttonHeight + margin + cellHeight * lineIndex, UPDATE_MODE_DU4);
+  pushView(lineView, UPDATE_MODE_DU4);
+}
+
+// Return view of table row for current input line
+CanvasView inputLineView()
+{
+  CanvasView lineView = {margin, margin + buttonHeight + margin + cellHeight * lineIndex, cellWidth * 5 + 1, cellHeight + 1};
+  return lineView;
 }
 
 // Update all screen with current status
@@ -353,7 +413,7 @@ void updateAllScreen()
 {
   // prevent ghost of e-ink
   screenCanvas.fillCanvas(whiteColor);
-  screenCanvas.pushCanvas(0, 0, UPDATE_MODE_A2);
+  pushView(fullScreenView, UPDATE_MODE_A2);
 
   // draw top buttons
   // NEW button
@@ -362,11 +422,13 @@ void updateAllScreen()
   screenCanvas.drawString("NEW", margin + (cellWidth - stringWidth("NEW", keyFontSize)) / 2, margin + (buttonHeight - keyFontHeight()) / 2);
 
   // Counter area
-  String statusString = String(lineIndex) + "/6";
+  char statusString[16];
+  snprintf(statusString, sizeof(statusString), "%d/6", lineIndex);
   screenCanvas.drawString(statusString, margin + cellWidth * 2 + (cellWidth - stringWidth(statusString, keyFontSize)) / 2, margin + (buttonHeight - keyFontHeight()) / 2);
 
   // Battery area
-  String batteryString = String(batteryPercent()) + "%";
+  char batteryString[16];
+  snprintf(batteryString, sizeof(batteryString), "%d%%", batteryPercent());
   screenCanvas.drawString(batteryString, margin + cellWidth * 3 + (cellWidth - stringWidth(batteryString, keyFontSize)) / 2, margin + (buttonHeight - keyFontHeight()) / 2);
 
   // OFF button
@@ -432,11 +494,10 @@ void updateAllScreen()
   }
 
   // Draw keyboard
-  int y = margin + buttonHeight + margin + cellHeight * 6;
-  keyboardCanvas.pushToCanvas(margin, y, &screenCanvas);
+  drawKeyboard();
 
   // Draw message
-  y += keyHeight * 3 + margin;
+  int y = keyboardView.y + keyHeight * 3 + margin;
   screenCanvas.setTextSize(keyFontSize);
   if (hitCount == 5)
   { // Correct answer
@@ -446,24 +507,30 @@ void updateAllScreen()
   else if (lineIndex > 5)
   { // Failed 6 times
     gameFinished = true;
-    screenCanvas.drawString("Failed! It was " + answer, margin, y);
+    char message[24];
+    snprintf(message, sizeof(message), "Failed! It was %s", answer);
+    screenCanvas.drawString(message, margin, y);
   }
 
   // Push canvas to update all screen
-  screenCanvas.pushCanvas(0, 0, UPDATE_MODE_GL16);
+  pushView(fullScreenView, UPDATE_MODE_GL16);
+
+  // Write trace records while screen is refreshing
+  traceFlush();
 }
 
 
-// Draw keyboard on keyboardCanvas without update all screen (Fast and low quality)
+// Draw keyboard in keyboardView of screenCanvas without pushing it
 void drawKeyboard()
 {
-  keyboardCanvas.fillCanvas(whiteColor);
+  screenCanvas.fillRect(keyboardView.x, keyboardView.y, keyboardView.width, keyboardView.height, whiteColor);
+  screenCanvas.setTextSize(keyFontSize);
 
-  int y = 0;
+  int y = keyboardView.y;
   // Keyboard line 1
   for (int i = 0; i < 10; i++)
   {
-    int x = i * keyWidth;
+    int x = keyboardView.x + i * keyWidth;
     drawKey(keyLine1[i], x, y);
   }
 
@@ -471,7 +538,7 @@ void drawKeyboard()
   y += keyHeight;
   for (int i = 0; i < 9; i++)
   {
-    int x = keyWidth / 2 + i * keyWidth;
+    int x = keyboardView.x + keyWidth / 2 + i * keyWidth;
     drawKey(keyLine2[i], x, y);
   }
 
@@ -479,7 +546,7 @@ void drawKeyboard()
   y += keyHeight;
   for (int i = 0; i < 10; i++)
   {
-    int x = i * keyWidth;
+    int x = keyboardView.x + i * keyWidth;
     drawKey(keyLine3[i], x, y);
   }
 }
@@ -487,67 +554,83 @@ void drawKeyboard()
 // Draw single key with char and state marker
 void drawKey(char key, int x, int y)
 {
-  keyboardCanvas.drawRect(x, y, keyWidth + 1, keyHeight + 1, blackColor);
-  if (hit.indexOf(key) > -1)
+  screenCanvas.drawRect(x, y, keyWidth + 1, keyHeight + 1, blackColor);
+  if (strchr(hit, key) != NULL)
   { // Circle: this key hit the answer word. it was correct char and correct position
-    keyboardCanvas.drawCircle(x + keyWidth / 2, y + keyHeight / 2, keyWidth / 2 - 8, blackColor);
+    screenCanvas.drawCircle(x + keyWidth / 2, y + keyHeight / 2, keyWidth / 2 - 8, blackColor);
   }
-  else if (contained.indexOf(key) > -1)
+  else if (strchr(contained, key) != NULL)
   { // Triangle: this key is contained in the answer word
-    keyboardCanvas.drawTriangle(x + keyWidth / 2, y + 8, x + 8, y + keyWidth - 8, x + keyWidth - 8, y + keyWidth - 8, blackColor);
+    screenCanvas.drawTriangle(x + keyWidth / 2, y + 8, x + 8, y + keyWidth - 8, x + keyWidth - 8, y + keyWidth - 8, blackColor);
   }
-  else if (notContained.indexOf(key) > -1)
+  else if (strchr(notContained, key) != NULL)
   { // Strikethrough: this key is used but not contained
-    keyboardCanvas.drawFastHLine(x + 8, y + keyHeight / 2, keyWidth - 16, blackColor);
+    screenCanvas.drawFastHLine(x + 8, y + keyHeight / 2, keyWidth - 16, blackColor);
   }
-  keyboardCanvas.drawString(String(key), x + (keyWidth - stringWidth(String(key), keyFontSize)) / 2, y + (keyHeight - keyFontHeight()) / 2);
+  char keyString[2] = {key, '\0'};
+  screenCanvas.drawString(keyString, x + (keyWidth - stringWidth(keyString, keyFontSize)) / 2, y + (keyHeight - keyFontHeight()) / 2);
 }
 
-// Return width of string using font size
-int stringWidth(String string, int fontSize)
+// Push rows of view from screenCanvas to EPD and update only the view rectangle
+// The rows are transferred full width in one call since they are contiguous in the framebuffer
+void pushView(const CanvasView &view, m5epd_update_mode_t mode)
 {
-  String key = String(fontSize) + string;
-  if (widthForStringMap.count(key) > 0)
-  { // Width value found in cache map
-    return widthForStringMap.at(key);
+  const uint8_t *buffer = (const uint8_t *)screenCanvas.frameBuffer(1);
+  M5.EPD.WritePartGram4bpp(0, view.y, screenWidth, view.height, buffer + view.y * screenWidth / 2);
+  M5.EPD.UpdateArea(view.x, view.y, view.width, view.height, mode);
+  tracePush(view.x, view.y, view.width, view.height, mode);
+}
+
+// Return width of string using font size. Sum of cached char widths
+int stringWidth(const char *string, int fontSize)
+{
+  int width = 0;
+  for (const char *c = string; *c != '\0'; c++)
+  {
+    width += charWidth(*c, fontSize);
   }
-  else
-  { // Not in cache map. Print char to test width
-    widthCanvas.setCursor(0, 0);
-    widthCanvas.setTextSize(fontSize);
-    widthCanvas.print(string);
-    int width = widthCanvas.getCursorX();
-    widthForStringMap.insert(std::make_pair(key, width));
-    return width;
-  }
-  return fontSize;
+  return width;
+}
+
+// Return width of single char using font size, measured by measureFontGeometry()
+int charWidth(char c, int fontSize)
+{
+  return charWidthCache[fontSize == cellFontSize ? 0 : 1][c & 0x7F];
+}
+
+// Print printable chars on screenCanvas to cache their widths and font heights
+// Called once before first drawing, then screenCanvas is cleared
+void measureFontGeometry()
+{
+  for (int cacheIndex = 0; cacheIndex < 2; cacheIndex++)
+  {
+    int fontSize = cacheIndex == 0 ? cellFontSize : keyFontSize;
+    screenCanvas.setTextSize(fontSize);
+    for (char c = ' '; c <= '~'; c++)
+    {
+      screenCanvas.setCursor(0, 0);
+      screenCanvas.print(c);
+      charWidthCache[cacheIndex][(int)c] = screenCanvas.getCursorX();
+    }
+
+    // Print to estimate height
+    screenCanvas.setCursor(0, 0);
+    screenCanvas.print("A\n");
+    if (cacheIndex == 0)
+      _cellFontHeight = screenCanvas.getCursorY() * 2 / 3;
+    else
+      _keyFontHeight = screenCanvas.getCursorY() * 2 / 3;
+  }
+  screenCanvas.fillCanvas(whiteColor);
 }
 
 // Return font height using font size
 int cellFontHeight()
 {
-  if (_cellFontHeight > 0) 
-  { // Height is in cache
-    return _cellFontHeight;
-  }
-  // Print to estimate height
-  widthCanvas.setCursor(0, 0);
-  widthCanvas.setTextSize(cellFontSize);
-  widthCanvas.print("A\n");
-  _cellFontHeight = widthCanvas.getCursorY() * 2 / 3;
   return _cellFontHeight;
 }
 int keyFontHeight()
 {
-  if (_keyFontHeight > 0) 
-  { // Height is in cache
-    return _keyFontHeight;
-  }
-  // Print to estimate height
-  widthCanvas.setCursor(0, 0);
-  widthCanvas.setTextSize(keyFontSize);
-  widthCanvas.print("A\n");
-  _keyFontHeight = widthCanvas.getCursorY() * 2 / 3;
   return _keyFontHeight;
 }
 
@@ -565,25 +648,23 @@ void savePGM(M5EPD_Canvas &canvas)
   uint8_t *buffer = (uint8_t *)(canvas.frameBuffer(1));
   int width = canvas.width();
   int height = canvas.height();
-  Serial.println(String(width) + " x " + String(height) + " = " + String(width * height) + ", bufferSize = " + String(bufferSize));
+  Serial.printf("%d x %d = %d, bufferSize = %u\n", width, height, width * height, bufferSize);
 
   // Open file
+  char fileName[24];
   int fileIndex = 1;
-  while (SD.exists("/ss" + String(fileIndex) + ".pgm"))
+  do
   {
+    snprintf(fileName, sizeof(fileName), "/ss%d.pgm", fileIndex);
     fileIndex++;
-  }
-  String fileName = "/ss" + String(fileIndex) + ".pgm";
-  Serial.println("File name = " + fileName);
+  } while (SD.exists(fileName));
+  Serial.printf("File name = %s\n", fileName);
   File pgmFile = SD.open(fileName, FILE_WRITE);
   if (!pgmFile)
     return;
 
   // Write PGM header
-  pgmFile.print("P5 ");
-  pgmFile.print(String(width) + " ");
-  pgmFile.print(String(height) + " ");
-  pgmFile.print("255 ");
+  pgmFile.printf("P5 %d %d 255 ", width, height);
 
   // Write PGM bytes
   for (uint32_t i = 0; i < (bufferSize); i++)
@@ -596,7 +677,60 @@ void savePGM(M5EPD_Canvas &canvas)
     pgmFile.write(low4bit);
   }
   pgmFile.close();
-  Serial.println("File wrote: " + fileName);
+  Serial.printf("File wrote: %s\n", fileName);
+}
+
+// Pack 5-letter uppercase word into 25 bits, 5 bits per letter. Returns 0 for invalid word
+uint32_t packWord(const char *word)
+{
+  uint32_t packed = 0;
+  for (int i = 0; i < 5; i++)
+  {
+    if (word[i] < 'A' || word[i] > 'Z')
+      return 0;
+    packed = (packed << 5) | (word[i] - 'A' + 1);
+  }
+  return packed;
+}
+
+// Unpack word packed by packWord() into 6 bytes buffer
+void unpackWord(uint32_t packed, char *word)
+{
+  for (int i = 4; i >= 0; i--)
+  {
+    word[i] = 'A' + (packed & 0x1F) - 1;
+    packed >>= 5;
+  }
+  word[5] = '\0';
+}
+
+// Read single line into buffer without String. Returns full line length, may be longer than buffer
+size_t readLine(File &file, char *buffer, size_t size)
+{
+  size_t length = 0;
+  while (file.available() > 0)
+  {
+    int c = file.read();
+    if (c == '\n')
+      break;
+    if (length < size - 1)
+      buffer[length] = c;
+    length++;
+  }
+  buffer[std::min(length, size - 1)] = '\0';
+  return length;
+}
+
+// Print framebuffer size and where it is placed
+void reportFramebuffer()
+{
+  void *buffer = screenCanvas.frameBuffer(1);
+  if (buffer == NULL)
+  {
+    Serial.println("Framebuffer: allocation failed");
+    return;
+  }
+  Serial.printf("Framebuffer: %u bytes in %s\n", screenCanvas.getBufferSize(), esp_ptr_external_ram(buffer) ? "PSRAM" : "internal RAM");
 }
 
 // Load current answer, previous inputs from state.txt in SD card
@@ -608,17 +742,19 @@ void loadState()
     if (stateFile)
     {
       lineIndex = -1;
+      char line[16];
       while (stateFile.available() > 0)
       {
-        String line = stateFile.readStringUntil('\n');
+        size_t length = readLine(stateFile, line, sizeof(line));
         if (lineIndex == -1)
         { // First line is current answer
-          answer = line;
+          strncpy(answer, line, 5);
+          answer[5] = '\0';
           lineIndex = 0;
         }
         else if (lineIndex < 6)
         { // Put other 6 lines into table
-          if (line.length() >= 5)
+          if (length >= 5)
           {
             addWordToTable(line);
           }
@@ -674,15 +810,22 @@ void loadWordList()
   File wordFile = SD.open("/words.txt");
   if (wordFile)
   {
+    char line[8];
     while (wordFile.available() > 0)
     {
-      String line = wordFile.readStringUntil('\n');
-      if (line.length() == 5)
+      if (readLine(wordFile, line, sizeof(line)) == 5)
       {
-        line.toUpperCase();
-        wordSet.insert(line);
+        for (int i = 0; i < 5; i++)
+        {
+          line[i] = toupper(line[i]);
+        }
+        uint32_t packed = packWord(line);
+        if (packed > 0)
+          wordList.push_back(packed);
       }
     }
+    std::sort(wordList.begin(), wordList.end());
+    wordList.erase(std::unique(wordList.begin(), wordList.end()), wordList.end());
   }
   wordFile.close();
 }
@@ -693,46 +836,24 @@ void startNewGame()
   // Clear variables
   memset(table, 0, sizeof(table));
   memset(state, 0, sizeof(state));
-  hit = "";
-  contained = "";
-  notContained = "";
-  inputLine = "";
+  hit[0] = '\0';
+  contained[0] = '\0';
+  notContained[0] = '\0';
+  inputLine[0] = '\0';
+  inputLength = 0;
   lineIndex = 0;
   gameFinished = false;
 
-  //load all words from "words.txt" in SD card
-  if (SD.exists("/words.txt"))
-  { 
-    File wordFile = SD.open("/words.txt");
-    if (wordFile)
-    {
-      std::vector<String> allWords;
-
-      while (wordFile.available() > 0)
-      {
-        String line = wordFile.readStringUntil('\n');
-        if (line.length() == 5)
-        {
-          line.toUpperCase();
-          allWords.push_back(line);
-        }
-      }
-
-      //Set answer randomly
-      srand(millis());
-      answer = allWords[rand() % allWords.size()];
-      Serial.println(answer);
-    }
-    wordFile.close();
+  //Set answer randomly
+  srand(millis());
+  if (!wordList.empty())
+  { // Pick answer from word list loaded from "words.txt" in SD card
+    unpackWord(wordList[rand() % wordList.size()], answer);
   }
   else
-  {
-    // No words.txt in SD card
-    answer = ".....";
-
-    addWordToTable("PLACE");
-    addWordToTable("WORDS");
-    addWordToTable("FILE ");
-    addWordToTable("ON SD");
+  { // No words.txt in SD card. Pick answer from built-in word list
+    unpackWord(embeddedWords[rand() % embeddedWordCount], answer);
   }
+  traceAnswer(packWord(answer));
+  Serial.println(answer);
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+// Minimal Arduino API for env:native, enough to build main.cpp on host for trace replay
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <algorithm>
+
+typedef bool boolean;
+#define B00001111 0x0F
+
+// Virtual clock in microseconds. Advanced by delay() and by the replay tool, never sleeps
+extern uint64_t nativeClockMicros;
+inline unsigned long micros() { return (unsigned long)nativeClockMicros; }
+inline unsigned long millis() { return (unsigned long)(nativeClockMicros / 1000); }
+inline void delay(unsigned long ms) { nativeClockMicros += (uint64_t)ms * 1000; }
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size-- > 0)
+      n += write(*buffer++);
+    return n;
+  }
+  size_t print(const char *string) { return write((const uint8_t *)string, strlen(string)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t println(const char *string) { return print(string) + print('\n'); }
+  size_t println(char c) { return print(c) + print('\n'); }
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+  {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return print(buffer);
+  }
+};
+
+// Serial output goes to stderr when nativeSerialEnabled, otherwise discarded
+extern bool nativeSerialEnabled;
+class HardwareSerial : public Print
+{
+public:
+  void begin(unsigned long baud) {}
+  size_t write(uint8_t c)
+  {
+    if (nativeSerialEnabled)
+      fputc(c, stderr);
+    return 1;
+  }
+  using Print::write;
+};
+extern HardwareSerial Serial;
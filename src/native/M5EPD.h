@@ -0,0 +1,238 @@
+#pragma once
+// Minimal M5EPD API for env:native. Touch input is fed by the replay tool,
+// canvas drawing keeps a real 4bpp framebuffer but does not render text or shapes
+#include <Arduino.h>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+typedef enum
+{
+  UPDATE_MODE_INIT = 0,
+  UPDATE_MODE_DU = 1,
+  UPDATE_MODE_GC16 = 2,
+  UPDATE_MODE_GL16 = 3,
+  UPDATE_MODE_GLR16 = 4,
+  UPDATE_MODE_GLD16 = 5,
+  UPDATE_MODE_DU4 = 6,
+  UPDATE_MODE_A2 = 7,
+  UPDATE_MODE_NONE = 8
+} m5epd_update_mode_t;
+
+typedef struct
+{
+  uint16_t x;
+  uint16_t y;
+  uint16_t size;
+  uint8_t id;
+} tp_finger_t;
+
+// SD card is a host directory, set by nativeSDRoot
+extern char nativeSDRoot[256];
+
+class File : public Print
+{
+public:
+  File(FILE *file = NULL) : _file(file) {}
+  operator bool() const { return _file != NULL; }
+  int available()
+  {
+    if (_file == NULL)
+      return 0;
+    long position = ftell(_file);
+    fseek(_file, 0, SEEK_END);
+    long size = ftell(_file);
+    fseek(_file, position, SEEK_SET);
+    return (int)(size - position);
+  }
+  int read() { return _file != NULL ? fgetc(_file) : -1; }
+  size_t write(uint8_t c) { return _file != NULL && fputc(c, _file) != EOF ? 1 : 0; }
+  size_t write(const uint8_t *buffer, size_t size) { return _file != NULL ? fwrite(buffer, 1, size, _file) : 0; }
+  void flush()
+  {
+    if (_file != NULL)
+      fflush(_file);
+  }
+  void close()
+  {
+    if (_file != NULL)
+      fclose(_file);
+    _file = NULL;
+  }
+
+private:
+  FILE *_file;
+};
+
+class SDClass
+{
+public:
+  bool exists(const char *path)
+  {
+    FILE *file = fopen(hostPath(path), "rb");
+    if (file == NULL)
+      return false;
+    fclose(file);
+    return true;
+  }
+  File open(const char *path, const char *mode = FILE_READ)
+  {
+    const char *hostMode = strcmp(mode, FILE_WRITE) == 0 ? "wb" : strcmp(mode, FILE_APPEND) == 0 ? "ab" : "rb";
+    return File(fopen(hostPath(path), hostMode));
+  }
+  bool remove(const char *path) { return ::remove(hostPath(path)) == 0; }
+
+private:
+  const char *hostPath(const char *path)
+  {
+    snprintf(_path, sizeof(_path), "%s%s", nativeSDRoot, path);
+    return _path;
+  }
+  char _path[512];
+};
+extern SDClass SD;
+
+class M5EPD_Driver
+{
+public:
+  void SetRotation(uint16_t rotate) {}
+  void Clear(bool init) {}
+  void WritePartGram4bpp(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t *gram) {}
+  void UpdateArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, m5epd_update_mode_t mode) {}
+};
+
+// Touch panel. Replay tool sets nativePending and nativeFinger before each loop()
+class GT911
+{
+public:
+  void SetRotation(uint16_t rotate) {}
+  bool avaliable() { return nativePending; }
+  bool isFingerUp() { return nativeFingerUp; }
+  void update() {}
+  tp_finger_t readFinger(uint8_t num)
+  {
+    nativePending = false;
+    return nativeFinger;
+  }
+
+  bool nativePending = false;
+  bool nativeFingerUp = false;
+  tp_finger_t nativeFinger = {0, 0, 0, 0};
+};
+
+class Button
+{
+public:
+  bool wasPressed() { return false; }
+};
+
+class M5EPD
+{
+public:
+  void begin() {}
+  void update() {}
+  void shutdown() { nativeShutdown = true; }
+  uint32_t getBatteryVoltage() { return 4000; }
+
+  M5EPD_Driver EPD;
+  GT911 TP;
+  Button BtnP;
+  bool nativeShutdown = false;
+};
+extern M5EPD M5;
+
+class M5EPD_Canvas : public Print
+{
+public:
+  M5EPD_Canvas(M5EPD_Driver *driver) {}
+  ~M5EPD_Canvas() { free(_buffer); }
+  void *createCanvas(int16_t width, int16_t height)
+  {
+    _width = width;
+    _height = height;
+    _buffer = (uint8_t *)calloc(getBufferSize(), 1);
+    return _buffer;
+  }
+  void *frameBuffer(int8_t f) { return _buffer; }
+  uint32_t getBufferSize() { return (uint32_t)_width * _height / 2; }
+  int16_t width() { return _width; }
+  int16_t height() { return _height; }
+  void pushCanvas(int32_t x, int32_t y, m5epd_update_mode_t mode) {}
+
+  // Fonts: builtin 6x8 font scaled by text size
+  uint16_t fontsLoaded() { return 0; }
+  bool loadFont(const char *path, SDClass &fs) { return false; }
+  bool createRender(uint16_t size, uint16_t cache_size) { return false; }
+  void setTextColor(uint16_t color) {}
+  void setTextSize(uint8_t size) { _textSize = size; }
+  void setCursor(int16_t x, int16_t y)
+  {
+    _cursorX = x;
+    _cursorY = y;
+  }
+  int16_t getCursorX() { return _cursorX; }
+  int16_t getCursorY() { return _cursorY; }
+  size_t write(uint8_t c)
+  {
+    if (c == '\n')
+    {
+      _cursorX = 0;
+      _cursorY += 8 * _textSize;
+    }
+    else
+    {
+      _cursorX += 6 * _textSize;
+    }
+    return 1;
+  }
+  using Print::write;
+  int16_t drawString(const char *string, int32_t x, int32_t y) { return 0; }
+
+  // Fills and rectangles touch the framebuffer, other shapes are no-op
+  void fillCanvas(uint32_t color) { fillRect(0, 0, _width, _height, color); }
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+  {
+    for (int32_t py = std::max(y, 0); py < std::min(y + h, (int32_t)_height); py++)
+      for (int32_t px = std::max(x, 0); px < std::min(x + w, (int32_t)_width); px++)
+        setPixel(px, py, color);
+  }
+  void ReversePartColor(int32_t x, int32_t y, int32_t w, int32_t h)
+  {
+    for (int32_t py = std::max(y, 0); py < std::min(y + h, (int32_t)_height); py++)
+      for (int32_t px = std::max(x, 0); px < std::min(x + w, (int32_t)_width); px++)
+        setPixel(px, py, 15 - getPixel(px, py));
+  }
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) { fillRect(x, y, w, 1, color); }
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) { fillRect(x, y, 1, h, color); }
+  void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+  {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+  void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {}
+  void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {}
+  void drawTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) {}
+  void fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) {}
+
+private:
+  void setPixel(int32_t x, int32_t y, uint32_t color)
+  {
+    uint8_t &byte = _buffer[(y * _width + x) / 2];
+    byte = (x & 1) ? (byte & 0xF0) | (color & 0x0F) : (byte & 0x0F) | (color << 4);
+  }
+  uint8_t getPixel(int32_t x, int32_t y)
+  {
+    uint8_t byte = _buffer[(y * _width + x) / 2];
+    return (x & 1) ? byte & 0x0F : byte >> 4;
+  }
+
+  uint8_t *_buffer = NULL;
+  int16_t _width = 0;
+  int16_t _height = 0;
+  uint8_t _textSize = 1;
+  int16_t _cursorX = 0;
+  int16_t _cursorY = 0;
+};
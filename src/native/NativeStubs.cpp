@@ -0,0 +1,11 @@
+#ifdef NATIVE_REPLAY
+#include <M5EPD.h>
+
+// Globals of Arduino and M5EPD stubs for env:native
+uint64_t nativeClockMicros = 0;
+bool nativeSerialEnabled = false;
+char nativeSDRoot[256] = ".";
+HardwareSerial Serial;
+SDClass SD;
+M5EPD M5;
+#endif
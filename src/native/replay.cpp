@@ -0,0 +1,389 @@
+#ifdef NATIVE_REPLAY
+// Touch trace replay tool for env:native
+// Feeds touch samples recorded by env:m5stack-fire-trace back through loop() and reports
+// processing time, latency, and touches dropped or duplicated by the lastFingerItem dedup in loop()
+// Key flash latency is time to first EPD push caused by a touch (inverted key).
+// Touch-to-update latency is time to last push, which shows the result (input line or whole screen).
+// Replayed latency is virtual time (delay() and backlog of samples), EPD transfer is not modeled
+//
+// Usage: program [--words words.txt] [--serial] trace.bin
+//   --words   use this words.txt as SD card word list (default: built-in word list)
+//   --serial  print Serial output of the sketch to stderr
+// Exit code is 1 when replayed keys differ from recorded keys
+
+#include <Arduino.h>
+#include <M5EPD.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "TouchTrace.h"
+
+// Sketch in main.cpp
+void setup();
+void loop();
+void unpackWord(uint32_t packed, char *word);
+extern tp_finger_t lastFingerItem;
+extern char answer[6];
+
+// Record with time unwrapped to 64 bit, since micros() wraps after 71 minutes on device
+struct TraceEvent
+{
+  uint64_t time;
+  TraceRecord record;
+};
+
+// Key and push events of the sketch during replay, timed by virtual clock
+static std::vector<TraceEvent> replayEvents;
+
+// Answers chosen by startNewGame() on device, forced in same order during replay
+// since rand() of host differs from device
+static std::vector<uint32_t> recordedAnswers;
+static size_t nextAnswer = 0;
+
+static void replayRecord(uint8_t type, uint8_t value)
+{
+  TraceEvent event = {nativeClockMicros, {(uint32_t)nativeClockMicros, type, value, 0, 0, 0, 0}};
+  replayEvents.push_back(event);
+}
+
+// Trace hooks called by main.cpp
+void traceBegin(const char *answer, const char table[6][5]) {}
+void traceTouch(const tp_finger_t &finger) {}
+void traceRelease() {}
+void traceKey(char key) { replayRecord(traceTypeKey, key); }
+void tracePush(int x, int y, int width, int height, m5epd_update_mode_t mode) { replayRecord(traceTypePush, mode); }
+void traceAnswer(uint32_t packedAnswer)
+{
+  if (nextAnswer < recordedAnswers.size())
+    unpackWord(recordedAnswers[nextAnswer++], answer);
+}
+void traceFlush() {}
+
+// Collects values and prints count, min, average, 95th percentile and max
+class Stats
+{
+public:
+  void add(double value) { _values.push_back(value); }
+  void print(const char *label, const char *unit)
+  {
+    if (_values.empty())
+    {
+      printf("%-40s n=0\n", label);
+      return;
+    }
+    std::vector<double> sorted = _values;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (double value : sorted)
+      sum += value;
+    printf("%-40s n=%zu min %.1f avg %.1f p95 %.1f max %.1f %s\n", label, sorted.size(), sorted.front(), sum / sorted.size(),
+           sorted[(sorted.size() - 1) * 95 / 100], sorted.back(), unit);
+  }
+
+private:
+  std::vector<double> _values;
+};
+
+// Read header and records of trace file
+static bool readTrace(const char *path, TraceHeader &header, std::vector<TraceEvent> &events)
+{
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+  {
+    fprintf(stderr, "Cannot open %s\n", path);
+    return false;
+  }
+  if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, traceMagic, sizeof(header.magic)) != 0 ||
+      header.version != traceVersion || header.recordSize != sizeof(TraceRecord))
+  {
+    fprintf(stderr, "%s is not touch trace version %d\n", path, traceVersion);
+    fclose(file);
+    return false;
+  }
+
+  TraceEvent event;
+  uint64_t wrap = 0;
+  while (fread(&event.record, sizeof(event.record), 1, file) == 1)
+  {
+    if (!events.empty() && event.record.time < events.back().record.time)
+      wrap += 1ULL << 32;
+    event.time = wrap + event.record.time;
+    events.push_back(event);
+  }
+  fclose(file);
+  return true;
+}
+
+// Copy file on host. Used to put words.txt into SD directory
+static bool copyFile(const char *from, const char *to)
+{
+  FILE *in = fopen(from, "rb");
+  FILE *out = fopen(to, "wb");
+  bool copied = in != NULL && out != NULL;
+  char buffer[4096];
+  size_t size;
+  while (copied && (size = fread(buffer, 1, sizeof(buffer), in)) > 0)
+    copied = fwrite(buffer, 1, size, out) == size;
+  if (in != NULL)
+    fclose(in);
+  if (out != NULL)
+    fclose(out);
+  return copied;
+}
+
+// True after temporary SD directory was created. Until then nativeSDRoot is not ours to clean
+static bool sdCreated = false;
+
+// Create temporary SD directory with state.txt of trace header, and optional words.txt
+static bool prepareSD(const TraceHeader &header, const char *wordsPath)
+{
+  char directory[] = "/tmp/poodle-replay-XXXXXX";
+  if (mkdtemp(directory) == NULL)
+  {
+    fprintf(stderr, "Cannot create temporary SD directory\n");
+    return false;
+  }
+  snprintf(nativeSDRoot, sizeof(nativeSDRoot), "%s", directory);
+  sdCreated = true;
+
+  File stateFile = SD.open("/state.txt", FILE_WRITE);
+  if (!stateFile)
+    return false;
+  stateFile.write((const uint8_t *)header.answer, sizeof(header.answer));
+  stateFile.print('\n');
+  for (int row = 0; row < 6 && header.table[row][0] != 0; row++)
+  {
+    stateFile.write((const uint8_t *)header.table[row], sizeof(header.table[row]));
+    stateFile.print('\n');
+  }
+  stateFile.close();
+
+  if (wordsPath != NULL)
+  {
+    std::string wordsFile = std::string(nativeSDRoot) + "/words.txt";
+    if (!copyFile(wordsPath, wordsFile.c_str()))
+    {
+      fprintf(stderr, "Cannot copy %s\n", wordsPath);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Remove temporary SD directory
+static void cleanupSD()
+{
+  if (!sdCreated)
+    return;
+  SD.remove("/state.txt");
+  SD.remove("/words.txt");
+  rmdir(nativeSDRoot);
+}
+
+int main(int argc, char **argv)
+{
+  const char *tracePath = NULL;
+  const char *wordsPath = NULL;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--words") == 0 && i + 1 < argc)
+      wordsPath = argv[++i];
+    else if (strcmp(argv[i], "--serial") == 0)
+      nativeSerialEnabled = true;
+    else
+      tracePath = argv[i];
+  }
+  if (tracePath == NULL)
+  {
+    fprintf(stderr, "Usage: %s [--words words.txt] [--serial] trace.bin\n", argv[0]);
+    return 2;
+  }
+
+  TraceHeader header;
+  std::vector<TraceEvent> events;
+  if (!readTrace(tracePath, header, events))
+    return 2;
+  if (!prepareSD(header, wordsPath))
+  {
+    cleanupSD();
+    return 2;
+  }
+
+  // Recorded latency: first and last push after each touch, before next touch
+  Stats recordedFlashLatency, recordedUpdateLatency;
+  std::string recordedKeys;
+  size_t touchCount = 0, releaseCount = 0, pushCount = 0;
+  for (size_t i = 0; i < events.size(); i++)
+  {
+    const TraceRecord &record = events[i].record;
+    if (record.type == traceTypeKey)
+    {
+      recordedKeys += (char)record.value;
+    }
+    else if (record.type == traceTypeRelease)
+    {
+      releaseCount++;
+    }
+    else if (record.type == traceTypeAnswer)
+    {
+      recordedAnswers.push_back(record.x | (uint32_t)record.y << 16);
+    }
+    else if (record.type == traceTypePush)
+    {
+      pushCount++;
+    }
+    else if (record.type == traceTypeTouch)
+    {
+      touchCount++;
+      size_t firstPush = 0, lastPush = 0;
+      for (size_t j = i + 1; j < events.size() && events[j].record.type != traceTypeTouch; j++)
+      {
+        if (events[j].record.type == traceTypePush)
+        {
+          if (firstPush == 0)
+            firstPush = j;
+          lastPush = j;
+        }
+      }
+      if (firstPush > 0)
+      {
+        recordedFlashLatency.add((events[firstPush].time - events[i].time) / 1000.0);
+        recordedUpdateLatency.add((events[lastPush].time - events[i].time) / 1000.0);
+      }
+    }
+  }
+
+  // Start sketch at time of first record
+  nativeClockMicros = events.empty() ? 0 : events.front().time;
+  setup();
+  replayEvents.clear();
+  replayEvents.reserve(events.size());
+
+  // Feed touch samples and releases through loop() in recorded order
+  Stats hostTime, blockingTime, replayedFlashLatency, replayedUpdateLatency;
+  std::string replayedKeys;
+  int repeatedCount = 0, droppedCount = 0, duplicatedCount = 0;
+  bool released = true; // finger released since last accepted touch
+  int keysInPress = 0;
+  printf("%6s %10s %5s %5s  %-9s %3s %9s %9s %9s %9s\n", "#", "time_ms", "x", "y", "result", "key", "host_us", "block_ms", "flash_ms", "update_ms");
+  for (size_t i = 0; i < events.size() && !M5.nativeShutdown; i++)
+  {
+    const TraceEvent &event = events[i];
+    const TraceRecord &record = event.record;
+    if (record.type != traceTypeTouch && record.type != traceTypeRelease)
+      continue;
+
+    // Sample can't be read before it was recorded, but may be late if replay is behind
+    if (nativeClockMicros < event.time)
+      nativeClockMicros = event.time;
+    uint64_t startClock = nativeClockMicros;
+    size_t firstReplayEvent = replayEvents.size();
+    tp_finger_t lastFinger = lastFingerItem;
+
+    M5.TP.nativePending = true;
+    M5.TP.nativeFingerUp = record.type == traceTypeRelease;
+    M5.TP.nativeFinger.x = record.x;
+    M5.TP.nativeFinger.y = record.y;
+    M5.TP.nativeFinger.size = record.width;
+    M5.TP.nativeFinger.id = record.value;
+    std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+    loop();
+    double hostMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - wallStart).count();
+    M5.TP.nativePending = false;
+
+    if (record.type == traceTypeRelease)
+    {
+      released = true;
+      keysInPress = 0;
+      continue;
+    }
+
+    // Keys and first push caused by this sample
+    int keyCount = 0;
+    char key = ' ';
+    double flashLatency = -1, updateLatency = -1;
+    for (size_t j = firstReplayEvent; j < replayEvents.size(); j++)
+    {
+      if (replayEvents[j].record.type == traceTypeKey)
+      {
+        key = replayEvents[j].record.value;
+        replayedKeys += key;
+        keyCount++;
+      }
+      else if (replayEvents[j].record.type == traceTypePush)
+      {
+        updateLatency = (replayEvents[j].time - event.time) / 1000.0;
+        if (flashLatency < 0)
+          flashLatency = updateLatency;
+      }
+    }
+
+    // Classify by dedup of loop(): sample at same point as lastFingerItem is discarded
+    const char *result;
+    if (lastFinger.x == record.x && lastFinger.y == record.y)
+    {
+      if (released)
+      { // New press at exactly same point is lost. Count it once
+        result = "DROPPED";
+        droppedCount++;
+        released = false;
+      }
+      else
+      { // Same press, discarded as intended
+        result = "repeat";
+        repeatedCount++;
+      }
+    }
+    else
+    {
+      released = false;
+      if (keyCount > 0 && keysInPress > 0)
+      { // Finger moved within one press and typed again
+        result = "DUPLICATE";
+        duplicatedCount++;
+      }
+      else if (keyCount > 0)
+      {
+        result = "key";
+      }
+      else
+      {
+        result = updateLatency >= 0 ? "button" : "none";
+      }
+      keysInPress += keyCount;
+    }
+
+    hostTime.add(hostMicros);
+    blockingTime.add((nativeClockMicros - startClock) / 1000.0);
+    char flashString[16] = "-", updateString[16] = "-";
+    if (updateLatency >= 0)
+    {
+      replayedFlashLatency.add(flashLatency);
+      replayedUpdateLatency.add(updateLatency);
+      snprintf(flashString, sizeof(flashString), "%.1f", flashLatency);
+      snprintf(updateString, sizeof(updateString), "%.1f", updateLatency);
+    }
+    printf("%6zu %10.1f %5u %5u  %-9s %3c %9.1f %9.1f %9s %9s\n", i, (event.time - events.front().time) / 1000.0, record.x, record.y,
+           result, keyCount > 0 ? key : ' ', hostMicros, (nativeClockMicros - startClock) / 1000.0, flashString, updateString);
+  }
+  cleanupSD();
+
+  // Summary
+  double duration = events.empty() ? 0 : (events.back().time - events.front().time) / 1000000.0;
+  printf("\nTrace %s: %zu touches, %zu releases, %zu keys, %zu pushes in %.1f s\n", tracePath, touchCount, releaseCount,
+         recordedKeys.size(), pushCount, duration);
+  hostTime.print("Processing time on host", "us");
+  blockingTime.print("Blocking time in loop() (delay)", "ms");
+  recordedFlashLatency.print("Key flash latency, recorded", "ms");
+  replayedFlashLatency.print("Key flash latency, replayed", "ms");
+  recordedUpdateLatency.print("Touch-to-update latency, recorded", "ms");
+  replayedUpdateLatency.print("Touch-to-update latency, replayed", "ms");
+  printf("Repeated samples discarded by dedup: %d\n", repeatedCount);
+  printf("Dropped touches (new press at last point): %d\n", droppedCount);
+  printf("Duplicated keys (several keys in one press): %d\n", duplicatedCount);
+  bool keysMatch = recordedKeys == replayedKeys;
+  printf("Keys recorded: \"%s\"\nKeys replayed: \"%s\" (%s)\n", recordedKeys.c_str(), replayedKeys.c_str(), keysMatch ? "match" : "MISMATCH");
+  return keysMatch ? 0 : 1;
+}
+#endif
@@ -0,0 +1,3 @@
+#pragma once
+// Host has no PSRAM
+inline bool esp_ptr_external_ram(const void *p) { return false; }